@@ -1,3 +1,7 @@
+// clock_gettime() and CLOCK_MONOTONIC are POSIX, not ISO C
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
 #include "bitmap.h"
 
 /*
@@ -258,3 +262,864 @@ int measureQubit(QuantumCircuit *circuit, int qubitIndex)
     // Return measurement result
     return measurementResult;
 }
+
+/*
+This helper applies one recorded gate from the circuit's gate list to qubitStates without
+recording it again. Two-qubit gates are recorded as a control/target pair of consecutive entries,
+so the pair is applied as a CNOT and both entries are consumed. A replayed measurement leaves the qubit unchanged,
+because measuring a basis state always returns its current value. If bytesMoved is not NULL the bytes of gate
+records and qubit states read or written are added to it. It returns the number of gate entries consumed.
+*/
+static int applyRecordedGate(QuantumCircuit *circuit, int *qubitStates, int gateIndex, long *bytesMoved)
+{
+    Gate gate = circuit->gates[gateIndex];
+    long gateBytes = (long)sizeof(Gate);
+    long stateBytes = 0;
+    int span = 1;
+    switch (gate.gateType)
+    {
+    case SINGLE_QUBIT_GATE:
+        qubitStates[gate.qubitIndex] = !qubitStates[gate.qubitIndex];
+        stateBytes = 2 * (long)sizeof(int);
+        break;
+    case TWO_QUBIT_GATE:
+        if (gateIndex + 1 < circuit->numGates)
+        {
+            // The following entry is read to find the target of the pair
+            gateBytes += (long)sizeof(Gate);
+        }
+        if (gateIndex + 1 < circuit->numGates && circuit->gates[gateIndex + 1].gateType == TWO_QUBIT_GATE)
+        {
+            int target = circuit->gates[gateIndex + 1].qubitIndex;
+            stateBytes = (long)sizeof(int);
+            if (qubitStates[gate.qubitIndex] == 1)
+            {
+                qubitStates[target] = !qubitStates[target];
+                stateBytes += 2 * (long)sizeof(int);
+            }
+            span = 2;
+        }
+        break;
+    default:
+        // measurement entries and unsupported gate entries leave the state unchanged
+        break;
+    }
+    if (bytesMoved != NULL)
+    {
+        *bytesMoved += gateBytes + stateBytes;
+    }
+    return span;
+}
+
+/*
+This helper returns the current value of the monotonic clock in seconds.
+*/
+static double monotonicSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*
+This helper runs the replay loop shared by executeCircuit() and the job executor. It resets the qubit states
+to 0 and applies the recorded gates in order. If cancelFlag is not NULL it is read atomically at every gate
+boundary and execution stops as soon as it is set.
+It returns 0 when every gate was applied or -2 when execution was cancelled.
+*/
+static int executeGates(QuantumCircuit *circuit, ExecutionStats *stats, const int *cancelFlag)
+{
+    int numGatesApplied = 0;
+    int cancelled = 0;
+    long bytesMoved = (long)circuit->numQubits * (long)sizeof(int);
+    double start = monotonicSeconds();
+    for (int i = 0; i < circuit->numQubits; i++)
+    {
+        circuit->qubitStates[i] = 0;
+    }
+    while (numGatesApplied < circuit->numGates)
+    {
+        if (cancelFlag != NULL && __atomic_load_n(cancelFlag, __ATOMIC_ACQUIRE))
+        {
+            cancelled = 1;
+            break;
+        }
+        numGatesApplied += applyRecordedGate(circuit, circuit->qubitStates, numGatesApplied, &bytesMoved);
+    }
+    double seconds = monotonicSeconds() - start;
+    if (stats != NULL)
+    {
+        stats->numGatesApplied = numGatesApplied;
+        stats->bytesMoved = bytesMoved;
+        stats->seconds = seconds;
+        stats->bandwidth = seconds > 0 ? bytesMoved / seconds : 0.0;
+    }
+    return cancelled ? -2 : 0;
+}
+
+/*
+This function replays the gates recorded in a quantum circuit and stores the resulting state in its qubitStates.
+The recorded gate list defines the circuit: replay always starts from every qubit in state 0, so gates recorded by
+applySingleQubitGate() are not applied twice and calling it again gives the same state. Replayed measurements
+leave their qubit unchanged. If stats is not NULL it is filled with the number of gate entries applied, the bytes
+of gate records and qubit states the replay read or wrote, the elapsed wall-clock seconds and their ratio as
+the achieved bandwidth in bytes per second (0 if the elapsed time is below the clock resolution).
+It returns 0 on success or -1 if the circuit is NULL.
+*/
+int executeCircuit(QuantumCircuit *circuit, ExecutionStats *stats)
+{
+    if (circuit == NULL)
+    {
+        return -1;
+    }
+    return executeGates(circuit, stats, NULL);
+}
+
+// Shared state of the asynchronous job executor: a FIFO of pending jobs served by EXECUTOR_THREADS workers
+static pthread_mutex_t executorLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t executorWakeup = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t executorStopped = PTHREAD_COND_INITIALIZER;
+static pthread_t executorThreads[EXECUTOR_THREADS];
+static int executorStarted = 0;
+static int executorStopping = 0;
+static CircuitJob *jobQueueHead = NULL;
+static CircuitJob *jobQueueTail = NULL;
+
+/*
+This helper is the body of every executor worker thread. It takes jobs from the queue in submission order,
+executes each circuit with cancellation checked at gate boundaries, invokes the completion callback and then
+marks the job finished and wakes any thread waiting on it. A job released by destroyJob() from inside its own
+callback is freed here once the callback returns. It exits once the executor is stopping and the queue is empty.
+*/
+static void *executorWorker(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&executorLock);
+        while (jobQueueHead == NULL && !executorStopping)
+        {
+            pthread_cond_wait(&executorWakeup, &executorLock);
+        }
+        CircuitJob *job = jobQueueHead;
+        if (job == NULL)
+        {
+            pthread_mutex_unlock(&executorLock);
+            return NULL;
+        }
+        jobQueueHead = job->next;
+        if (jobQueueHead == NULL)
+        {
+            jobQueueTail = NULL;
+        }
+        pthread_mutex_unlock(&executorLock);
+
+        int result = -2;
+        pthread_mutex_lock(&job->lock);
+        int cancelled = __atomic_load_n(&job->cancelRequested, __ATOMIC_ACQUIRE);
+        if (!cancelled)
+        {
+            job->status = JOB_RUNNING;
+        }
+        pthread_mutex_unlock(&job->lock);
+        if (!cancelled)
+        {
+            result = executeGates(job->circuit, &job->stats, &job->cancelRequested);
+        }
+        pthread_mutex_lock(&job->lock);
+        job->result = result;
+        job->status = result == -2 ? JOB_CANCELLED : JOB_COMPLETED;
+        job->inCallback = 1;
+        job->callbackThread = pthread_self();
+        pthread_mutex_unlock(&job->lock);
+        // Run the callback before releasing waiters so the job cannot be destroyed underneath it
+        if (job->callback != NULL)
+        {
+            job->callback(job, job->userData);
+        }
+        pthread_mutex_lock(&job->lock);
+        job->inCallback = 0;
+        job->finished = 1;
+        int released = job->released;
+        pthread_cond_broadcast(&job->done);
+        pthread_mutex_unlock(&job->lock);
+        if (released)
+        {
+            pthread_mutex_destroy(&job->lock);
+            pthread_cond_destroy(&job->done);
+            free(job);
+        }
+    }
+}
+
+/*
+This function submits a quantum circuit for asynchronous execution on the internal executor and returns
+a job handle immediately. The executor threads are started on first use. The circuit is executed with
+executeCircuit() semantics, and must not be modified or destroyed until the job has finished.
+If callback is not NULL it is called on an executor thread with the job and userData once execution ends;
+it may call destroyJob() on its own job to release a fire-and-forget handle. It returns NULL if the circuit is NULL, the executor is shutting down, or the job could not be allocated or started.
+*/
+CircuitJob *submitCircuit(QuantumCircuit *circuit, JobCallback callback, void *userData)
+{
+    if (circuit == NULL)
+    {
+        return NULL;
+    }
+    CircuitJob *job = (CircuitJob *)malloc(sizeof(CircuitJob));
+    if (job == NULL)
+    {
+        // Memory allocation failed
+        return NULL;
+    }
+    job->circuit = circuit;
+    job->status = JOB_PENDING;
+    job->cancelRequested = 0;
+    job->finished = 0;
+    job->inCallback = 0;
+    job->released = 0;
+    job->result = 0;
+    job->stats.numGatesApplied = 0;
+    job->stats.bytesMoved = 0;
+    job->stats.seconds = 0.0;
+    job->stats.bandwidth = 0.0;
+    job->callback = callback;
+    job->userData = userData;
+    job->next = NULL;
+    pthread_mutex_init(&job->lock, NULL);
+    // Timed waits use the monotonic clock so wall-clock jumps cannot shorten or stretch them
+    pthread_condattr_t doneAttr;
+    pthread_condattr_init(&doneAttr);
+    pthread_condattr_setclock(&doneAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&job->done, &doneAttr);
+    pthread_condattr_destroy(&doneAttr);
+
+    pthread_mutex_lock(&executorLock);
+    if (executorStopping)
+    {
+        // Error: executor is shutting down
+        pthread_mutex_unlock(&executorLock);
+        pthread_mutex_destroy(&job->lock);
+        pthread_cond_destroy(&job->done);
+        free(job);
+        return NULL;
+    }
+    if (!executorStarted)
+    {
+        for (int i = 0; i < EXECUTOR_THREADS; i++)
+        {
+            if (pthread_create(&executorThreads[i], NULL, executorWorker, NULL) != 0)
+            {
+                // Thread creation failed, stop the workers that did start
+                executorStopping = 1;
+                pthread_cond_broadcast(&executorWakeup);
+                pthread_mutex_unlock(&executorLock);
+                for (int j = 0; j < i; j++)
+                {
+                    pthread_join(executorThreads[j], NULL);
+                }
+                pthread_mutex_lock(&executorLock);
+                executorStopping = 0;
+                pthread_cond_broadcast(&executorStopped);
+                pthread_mutex_unlock(&executorLock);
+                pthread_mutex_destroy(&job->lock);
+                pthread_cond_destroy(&job->done);
+                free(job);
+                return NULL;
+            }
+        }
+        executorStarted = 1;
+    }
+    if (jobQueueTail == NULL)
+    {
+        jobQueueHead = job;
+    }
+    else
+    {
+        jobQueueTail->next = job;
+    }
+    jobQueueTail = job;
+    pthread_cond_signal(&executorWakeup);
+    pthread_mutex_unlock(&executorLock);
+    return job;
+}
+
+/*
+This function returns the current status of a submitted job without blocking. It agrees with waitForJob():
+a job is reported as JOB_COMPLETED or JOB_CANCELLED only once its completion callback has returned, and as
+JOB_RUNNING until then. The callback itself can read the outcome from job->status and job->result.
+A NULL job is reported as JOB_CANCELLED.
+*/
+JobStatus pollJob(CircuitJob *job)
+{
+    if (job == NULL)
+    {
+        return JOB_CANCELLED;
+    }
+    pthread_mutex_lock(&job->lock);
+    JobStatus status = job->finished ? job->status : (job->status == JOB_PENDING ? JOB_PENDING : JOB_RUNNING);
+    pthread_mutex_unlock(&job->lock);
+    return status;
+}
+
+/*
+This function blocks until a submitted job has finished, including its completion callback, or until
+timeoutMs milliseconds have passed. A negative timeoutMs waits without a time limit.
+It returns 0 if the job finished, 1 if the timeout expired first, or -1 if the job is NULL.
+*/
+int waitForJob(CircuitJob *job, int timeoutMs)
+{
+    if (job == NULL)
+    {
+        return -1;
+    }
+    struct timespec deadline;
+    if (timeoutMs >= 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+    int timedOut = 0;
+    pthread_mutex_lock(&job->lock);
+    while (!job->finished && !timedOut)
+    {
+        if (timeoutMs < 0)
+        {
+            pthread_cond_wait(&job->done, &job->lock);
+        }
+        else if (pthread_cond_timedwait(&job->done, &job->lock, &deadline) != 0)
+        {
+            timedOut = !job->finished;
+        }
+    }
+    pthread_mutex_unlock(&job->lock);
+    return timedOut ? 1 : 0;
+}
+
+/*
+This function requests cancellation of a submitted job. A pending job is cancelled before it starts and a
+running job stops at the next gate boundary, leaving the qubit states as they were after the last applied gate.
+It returns 0 if cancellation was requested, -1 if the job is NULL, or -2 if the job had already completed.
+*/
+int cancelJob(CircuitJob *job)
+{
+    if (job == NULL)
+    {
+        return -1;
+    }
+    int result = 0;
+    pthread_mutex_lock(&job->lock);
+    if (job->status == JOB_COMPLETED || job->status == JOB_CANCELLED)
+    {
+        result = -2;
+    }
+    else
+    {
+        __atomic_store_n(&job->cancelRequested, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&job->lock);
+    return result;
+}
+
+/*
+This function releases a job handle. It waits for the job to finish first, so it is safe to call on a
+job that is still pending or running. Called from the job's own completion callback it does not wait; the job
+is freed when the callback returns, and no other thread may use the handle after that. The submitted circuit
+is not destroyed.
+*/
+void destroyJob(CircuitJob *job)
+{
+    if (job == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&job->lock);
+    if (job->inCallback && pthread_equal(job->callbackThread, pthread_self()))
+    {
+        // Called from the job's own callback: the worker frees the job once the callback returns
+        job->released = 1;
+        pthread_mutex_unlock(&job->lock);
+        return;
+    }
+    pthread_mutex_unlock(&job->lock);
+    waitForJob(job, -1);
+    pthread_mutex_destroy(&job->lock);
+    pthread_cond_destroy(&job->done);
+    free(job);
+}
+
+/*
+This function stops the asynchronous job executor. Jobs that are already queued are still executed,
+then the worker threads exit and are joined. Concurrent calls are safe: later callers wait for the shutdown in
+progress. It must not be called from a completion callback. A later call to submitCircuit() starts the executor again.
+*/
+void shutdownExecutor(void)
+{
+    pthread_mutex_lock(&executorLock);
+    // A concurrent shutdown owns the worker threads: wait for it instead of joining them twice
+    while (executorStopping)
+    {
+        pthread_cond_wait(&executorStopped, &executorLock);
+    }
+    if (!executorStarted)
+    {
+        pthread_mutex_unlock(&executorLock);
+        return;
+    }
+    executorStopping = 1;
+    pthread_cond_broadcast(&executorWakeup);
+    pthread_mutex_unlock(&executorLock);
+    for (int i = 0; i < EXECUTOR_THREADS; i++)
+    {
+        pthread_join(executorThreads[i], NULL);
+    }
+    pthread_mutex_lock(&executorLock);
+    executorStarted = 0;
+    executorStopping = 0;
+    pthread_cond_broadcast(&executorStopped);
+    pthread_mutex_unlock(&executorLock);
+}
+
+typedef struct
+{
+    int firstError;
+    int trajectory;
+} TrajectoryStart;
+
+typedef struct
+{
+    QuantumCircuit *circuit;
+    const NoiseModel *noise;
+    const int *spanEnd;
+    const TrajectoryStart *starts;
+    int numStarts;
+    unsigned long seed;
+    int *cursorStates;
+    int *states;
+    int *onesCounts;
+    int *outcomes;
+} TrajectoryTask;
+
+/*
+This helper advances a xorshift64* random stream and returns its next 64-bit value.
+*/
+static unsigned long long nextRandom(unsigned long long *rngState)
+{
+    unsigned long long x = *rngState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *rngState = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+This helper returns a uniformly distributed double in [0, 1) from the given random stream.
+*/
+static double nextUniform(unsigned long long *rngState)
+{
+    return (double)(nextRandom(rngState) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+This helper derives the starting state of the independent random stream of one trajectory from the run seed,
+using the splitmix64 finaliser so that neighbouring trajectory indices produce uncorrelated streams.
+*/
+static unsigned long long trajectorySeed(unsigned long seed, int trajectory)
+{
+    unsigned long long z = (unsigned long long)seed + (unsigned long long)(trajectory + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    // xorshift64* must never be seeded with 0
+    return z != 0 ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+/*
+This helper returns the probability that the gate errors of the noise model leave a qubit in state qubitState
+untouched after a gate acted on it. Depolarizing changes a basis state only through its X and Y parts, and
+amplitude damping can only act on a qubit in state 1.
+*/
+static double gateNoiseSurvival(const NoiseModel *noise, int qubitState)
+{
+    double damping = qubitState == 1 ? noise->amplitudeDamping : 0.0;
+    return (1.0 - noise->depolarizing * 2.0 / 3.0) * (1.0 - noise->bitFlip) * (1.0 - damping);
+}
+
+/*
+This helper injects the stochastic gate errors of the noise model on one qubit after a gate acted on it.
+A depolarizing X or Y error (probability 2/3 of the depolarizing rate) or a bit-flip error toggles the qubit,
+and amplitude damping relaxes a qubit in state 1 to state 0.
+*/
+static void applyGateNoise(int *qubitStates, int qubitIndex, const NoiseModel *noise, unsigned long long *rngState)
+{
+    if (noise->depolarizing > 0 && nextUniform(rngState) < noise->depolarizing * 2.0 / 3.0)
+    {
+        qubitStates[qubitIndex] = !qubitStates[qubitIndex];
+    }
+    if (noise->bitFlip > 0 && nextUniform(rngState) < noise->bitFlip)
+    {
+        qubitStates[qubitIndex] = !qubitStates[qubitIndex];
+    }
+    if (noise->amplitudeDamping > 0 && qubitStates[qubitIndex] == 1 && nextUniform(rngState) < noise->amplitudeDamping)
+    {
+        qubitStates[qubitIndex] = 0;
+    }
+}
+
+/*
+This helper injects the gate errors on one qubit conditioned on at least one error occurring, which is how a
+trajectory's first error is applied. It picks the first error channel that fires with its conditional probability,
+then draws the channels after it in the usual way, so together with the sampled error position the trajectory has
+the same distribution as one that draws every channel at every gate.
+*/
+static void applyFirstGateError(int *qubitStates, int qubitIndex, const NoiseModel *noise, unsigned long long *rngState)
+{
+    double flip = noise->depolarizing * 2.0 / 3.0;
+    double pick = nextUniform(rngState) * (1.0 - gateNoiseSurvival(noise, qubitStates[qubitIndex]));
+    if (pick < flip)
+    {
+        qubitStates[qubitIndex] = !qubitStates[qubitIndex];
+        if (noise->bitFlip > 0 && nextUniform(rngState) < noise->bitFlip)
+        {
+            qubitStates[qubitIndex] = !qubitStates[qubitIndex];
+        }
+    }
+    else if (pick < flip + (1.0 - flip) * noise->bitFlip)
+    {
+        qubitStates[qubitIndex] = !qubitStates[qubitIndex];
+    }
+    else
+    {
+        qubitStates[qubitIndex] = 0;
+        return;
+    }
+    if (noise->amplitudeDamping > 0 && qubitStates[qubitIndex] == 1 && nextUniform(rngState) < noise->amplitudeDamping)
+    {
+        qubitStates[qubitIndex] = 0;
+    }
+}
+
+/*
+This helper orders trajectory starts by the gate entry of their first error so that a task can serve them
+from one noiseless state that only ever moves forward.
+*/
+static int compareTrajectoryStarts(const void *left, const void *right)
+{
+    const TrajectoryStart *a = (const TrajectoryStart *)left;
+    const TrajectoryStart *b = (const TrajectoryStart *)right;
+    if (a->firstError != b->firstError)
+    {
+        return a->firstError < b->firstError ? -1 : 1;
+    }
+    return a->trajectory < b->trajectory ? -1 : (a->trajectory > b->trajectory);
+}
+
+/*
+This helper runs the trajectories assigned to one task in order of their first error. The task advances a
+noiseless cursor state gate by gate and copies it into each trajectory at the gate of its first error, so the
+error-free part of every trajectory is simulated once per task instead of once per trajectory. From there the
+trajectory applies its first error and replays the remaining gates with errors drawn from its own random stream,
+then reads out every qubit with readout error, adding the observed ones to the task's private counts and,
+if requested, storing the trajectory's outcomes in its row of the shared outcome array.
+*/
+static void *runTrajectoryTask(void *arg)
+{
+    TrajectoryTask *task = (TrajectoryTask *)arg;
+    QuantumCircuit *circuit = task->circuit;
+    const NoiseModel *noise = task->noise;
+    int cursorGate = 0;
+    for (int i = 0; i < circuit->numQubits; i++)
+    {
+        task->cursorStates[i] = 0;
+    }
+    for (int k = 0; k < task->numStarts; k++)
+    {
+        int firstError = task->starts[k].firstError;
+        int resumeGate = firstError < circuit->numGates ? task->spanEnd[firstError] : circuit->numGates;
+        while (cursorGate < resumeGate)
+        {
+            cursorGate += applyRecordedGate(circuit, task->cursorStates, cursorGate, NULL);
+        }
+        for (int i = 0; i < circuit->numQubits; i++)
+        {
+            task->states[i] = task->cursorStates[i];
+        }
+        unsigned long long rngState = trajectorySeed(task->seed, task->starts[k].trajectory);
+        // Skip the draw that placed this trajectory's first error
+        nextUniform(&rngState);
+        if (firstError < circuit->numGates)
+        {
+            applyFirstGateError(task->states, circuit->gates[firstError].qubitIndex, noise, &rngState);
+            for (int i = firstError + 1; i < resumeGate; i++)
+            {
+                applyGateNoise(task->states, circuit->gates[i].qubitIndex, noise, &rngState);
+            }
+        }
+        int gateIndex = resumeGate;
+        while (gateIndex < circuit->numGates)
+        {
+            int span = applyRecordedGate(circuit, task->states, gateIndex, NULL);
+            for (int i = gateIndex; i < gateIndex + span; i++)
+            {
+                if (circuit->gates[i].gateType != MEASUREMENT_GATE)
+                {
+                    applyGateNoise(task->states, circuit->gates[i].qubitIndex, noise, &rngState);
+                }
+            }
+            gateIndex += span;
+        }
+        for (int i = 0; i < circuit->numQubits; i++)
+        {
+            int outcome = task->states[i];
+            if (noise->readoutError > 0 && nextUniform(&rngState) < noise->readoutError)
+            {
+                outcome = !outcome;
+            }
+            task->onesCounts[i] += outcome;
+            if (task->outcomes != NULL)
+            {
+                task->outcomes[(size_t)task->starts[k].trajectory * circuit->numQubits + i] = outcome;
+            }
+        }
+    }
+    return NULL;
+}
+
+/*
+This function simulates a quantum circuit under a noise model using Monte Carlo trajectories.
+Like executeCircuit(), every trajectory replays the recorded gates starting from every qubit in state 0,
+injecting depolarizing, bit-flip and amplitude damping errors on the qubits of each gate, and finally reads out
+every qubit with readout error. The position of each trajectory's first error is sampled up front from the
+noiseless run, and the trajectories are sorted by it, so the error-free part of each trajectory is taken from
+a shared noiseless state instead of being simulated again. Trajectories run on up to TRAJECTORY_THREADS threads,
+each with its own random stream derived from seed, so the result does not depend on the number of threads.
+The circuit itself is not modified. On success onesCounts[i] holds how many trajectories read qubit i as 1.
+These are marginal counts only; to see correlations between qubits, such as between the control and target of a
+two-qubit gate, pass an outcomes array of numTrajectories * numQubits entries and outcomes[t * numQubits + i]
+receives the value read from qubit i in trajectory t. Pass NULL for outcomes when only the counts are needed.
+It returns 0 on success, -1 if the circuit is NULL, -2 if any other argument is invalid,
+or -3 if memory allocation fails.
+*/
+int runNoisyTrajectories(QuantumCircuit *circuit, const NoiseModel *noise, int numTrajectories, unsigned long seed, int *onesCounts,
+                         int *outcomes)
+{
+    if (circuit == NULL)
+    {
+        return -1;
+    }
+    if (noise == NULL || onesCounts == NULL || numTrajectories <= 0)
+    {
+        return -2;
+    }
+    if (noise->depolarizing < 0 || noise->depolarizing > 1 || noise->bitFlip < 0 || noise->bitFlip > 1 ||
+        noise->amplitudeDamping < 0 || noise->amplitudeDamping > 1 || noise->readoutError < 0 || noise->readoutError > 1)
+    {
+        // Error: probabilities must lie in [0, 1]
+        return -2;
+    }
+    int numThreads = numTrajectories < TRAJECTORY_THREADS ? numTrajectories : TRAJECTORY_THREADS;
+    int numQubits = circuit->numQubits;
+    int numGates = circuit->numGates;
+    // Allocate at least one element so empty circuits never depend on malloc(0)
+    size_t qubitSlots = numQubits > 0 ? (size_t)numQubits : 1;
+    size_t gateSlots = numGates > 0 ? (size_t)numGates : 1;
+    int *noiselessStates = (int *)calloc(qubitSlots, sizeof(int));
+    double *survival = (double *)malloc(gateSlots * sizeof(double));
+    int *spanEnd = (int *)malloc(gateSlots * sizeof(int));
+    TrajectoryStart *starts = (TrajectoryStart *)malloc(numTrajectories * sizeof(TrajectoryStart));
+    int *taskStates = (int *)malloc(2 * numThreads * qubitSlots * sizeof(int));
+    int *taskCounts = (int *)calloc(numThreads * qubitSlots, sizeof(int));
+    TrajectoryTask *tasks = (TrajectoryTask *)malloc(numThreads * sizeof(TrajectoryTask));
+    pthread_t *threads = (pthread_t *)malloc(numThreads * sizeof(pthread_t));
+    int *started = (int *)calloc(numThreads, sizeof(int));
+    if (noiselessStates == NULL || survival == NULL || spanEnd == NULL || starts == NULL || taskStates == NULL ||
+        taskCounts == NULL || tasks == NULL || threads == NULL || started == NULL)
+    {
+        // Memory allocation failed
+        free(noiselessStates);
+        free(survival);
+        free(spanEnd);
+        free(starts);
+        free(taskStates);
+        free(taskCounts);
+        free(tasks);
+        free(threads);
+        free(started);
+        return -3;
+    }
+    // One noiseless pass records, after every gate entry, the probability that no error has happened yet
+    double noErrorYet = 1.0;
+    int gateIndex = 0;
+    while (gateIndex < numGates)
+    {
+        int span = applyRecordedGate(circuit, noiselessStates, gateIndex, NULL);
+        for (int i = gateIndex; i < gateIndex + span; i++)
+        {
+            if (circuit->gates[i].gateType != MEASUREMENT_GATE)
+            {
+                noErrorYet *= gateNoiseSurvival(noise, noiselessStates[circuit->gates[i].qubitIndex]);
+            }
+            survival[i] = noErrorYet;
+            spanEnd[i] = gateIndex + span;
+        }
+        gateIndex += span;
+    }
+    // Each trajectory's first draw places its first error: the first entry whose survival drops to the draw
+    for (int t = 0; t < numTrajectories; t++)
+    {
+        unsigned long long rngState = trajectorySeed(seed, t);
+        double draw = nextUniform(&rngState);
+        int low = 0;
+        int high = numGates;
+        while (low < high)
+        {
+            int middle = low + (high - low) / 2;
+            if (survival[middle] <= draw)
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
+            }
+        }
+        starts[t].firstError = low;
+        starts[t].trajectory = t;
+    }
+    qsort(starts, numTrajectories, sizeof(TrajectoryStart), compareTrajectoryStarts);
+    for (int t = 0; t < numThreads; t++)
+    {
+        int first = (int)((long)numTrajectories * t / numThreads);
+        int last = (int)((long)numTrajectories * (t + 1) / numThreads);
+        tasks[t].circuit = circuit;
+        tasks[t].noise = noise;
+        tasks[t].spanEnd = spanEnd;
+        tasks[t].starts = starts + first;
+        tasks[t].numStarts = last - first;
+        tasks[t].seed = seed;
+        tasks[t].cursorStates = taskStates + 2 * t * qubitSlots;
+        tasks[t].states = taskStates + (2 * t + 1) * qubitSlots;
+        tasks[t].onesCounts = taskCounts + t * qubitSlots;
+        tasks[t].outcomes = outcomes;
+        // The last task runs on the calling thread, as does any task whose thread fails to start
+        if (t < numThreads - 1 && pthread_create(&threads[t], NULL, runTrajectoryTask, &tasks[t]) == 0)
+        {
+            started[t] = 1;
+        }
+        else
+        {
+            runTrajectoryTask(&tasks[t]);
+        }
+    }
+    for (int i = 0; i < numQubits; i++)
+    {
+        onesCounts[i] = 0;
+    }
+    for (int t = 0; t < numThreads; t++)
+    {
+        if (started[t])
+        {
+            pthread_join(threads[t], NULL);
+        }
+        for (int i = 0; i < numQubits; i++)
+        {
+            onesCounts[i] += tasks[t].onesCounts[i];
+        }
+    }
+    free(noiselessStates);
+    free(survival);
+    free(spanEnd);
+    free(starts);
+    free(taskStates);
+    free(taskCounts);
+    free(tasks);
+    free(threads);
+    free(started);
+    return 0;
+}
+
+/*
+This function computes the exact expectation value <psi|H|psi> of a weighted sum of Pauli strings
+H = sum of terms[k].coefficient * terms[k].paulis without sampling. Like executeCircuit() and
+runNoisyTrajectories(), psi is the basis state obtained by replaying the recorded gates from every qubit in state 0.
+Each Pauli string has one character per qubit from "IXYZ", where character i acts on qubit i.
+A term containing X or Y maps the basis state to an orthogonal one and contributes exactly 0, while a term made
+of I and Z contributes its coefficient times the parity sign of the qubits in state 1 under its Z factors.
+It returns 0 on success with the value stored in expectation, -1 if the circuit is NULL,
+-2 if any other argument or Pauli string is invalid, or -3 if memory allocation fails.
+*/
+int computeExpectationValue(QuantumCircuit *circuit, const PauliTerm *terms, int numTerms, double *expectation)
+{
+    if (circuit == NULL)
+    {
+        return -1;
+    }
+    if (expectation == NULL || numTerms < 0 || (terms == NULL && numTerms > 0))
+    {
+        return -2;
+    }
+    int numQubits = circuit->numQubits;
+    int *states = (int *)calloc(numQubits > 0 ? numQubits : 1, sizeof(int));
+    if (states == NULL)
+    {
+        // Memory allocation failed
+        return -3;
+    }
+    for (int gateIndex = 0; gateIndex < circuit->numGates;)
+    {
+        gateIndex += applyRecordedGate(circuit, states, gateIndex, NULL);
+    }
+    int result = 0;
+    double sum = 0.0;
+    for (int k = 0; k < numTerms && result == 0; k++)
+    {
+        const char *paulis = terms[k].paulis;
+        if (paulis == NULL)
+        {
+            result = -2;
+            break;
+        }
+        int diagonal = 1;
+        int parity = 0;
+        for (int q = 0; q < numQubits && result == 0; q++)
+        {
+            switch (paulis[q])
+            {
+            case 'I':
+                break;
+            case 'Z':
+                parity ^= states[q];
+                break;
+            case 'X':
+            case 'Y':
+                diagonal = 0;
+                break;
+            default:
+                // Error: invalid Pauli character or string shorter than numQubits
+                result = -2;
+                break;
+            }
+        }
+        if (result == 0 && paulis[numQubits] != '\0')
+        {
+            // Error: Pauli string longer than numQubits
+            result = -2;
+        }
+        if (result == 0 && diagonal)
+        {
+            sum += parity ? -terms[k].coefficient : terms[k].coefficient;
+        }
+    }
+    free(states);
+    if (result == 0)
+    {
+        *expectation = sum;
+    }
+    return result;
+}
@@ -62,3 +62,108 @@ index is invalid or if the last gate in the circuit is not the expected measurem
 int measureQubit(QuantumCircuit *circuit, int qubitIndex)
 {
 }
+
+/*
+This function replays the gates recorded in a quantum circuit and stores the resulting state in its qubitStates.
+The recorded gate list defines the circuit: replay always starts from every qubit in state 0, so gates recorded by
+applySingleQubitGate() are not applied twice and calling it again gives the same state. Replayed measurements
+leave their qubit unchanged. If stats is not NULL it is filled with the number of gate entries applied, the bytes
+of gate records and qubit states the replay read or wrote, the elapsed wall-clock seconds and their ratio as
+the achieved bandwidth in bytes per second (0 if the elapsed time is below the clock resolution).
+It returns 0 on success or -1 if the circuit is NULL.
+*/
+int executeCircuit(QuantumCircuit *circuit, ExecutionStats *stats)
+{
+}
+
+/*
+This function submits a quantum circuit for asynchronous execution on the internal executor and returns
+a job handle immediately. The executor threads are started on first use. The circuit is executed with
+executeCircuit() semantics, and must not be modified or destroyed until the job has finished.
+If callback is not NULL it is called on an executor thread with the job and userData once execution ends;
+it may call destroyJob() on its own job to release a fire-and-forget handle. It returns NULL if the circuit is NULL, the executor is shutting down, or the job could not be allocated or started.
+*/
+CircuitJob *submitCircuit(QuantumCircuit *circuit, JobCallback callback, void *userData)
+{
+}
+
+/*
+This function returns the current status of a submitted job without blocking. It agrees with waitForJob():
+a job is reported as JOB_COMPLETED or JOB_CANCELLED only once its completion callback has returned, and as
+JOB_RUNNING until then. The callback itself can read the outcome from job->status and job->result.
+A NULL job is reported as JOB_CANCELLED.
+*/
+JobStatus pollJob(CircuitJob *job)
+{
+}
+
+/*
+This function blocks until a submitted job has finished, including its completion callback, or until
+timeoutMs milliseconds have passed. A negative timeoutMs waits without a time limit.
+It returns 0 if the job finished, 1 if the timeout expired first, or -1 if the job is NULL.
+*/
+int waitForJob(CircuitJob *job, int timeoutMs)
+{
+}
+
+/*
+This function requests cancellation of a submitted job. A pending job is cancelled before it starts and a
+running job stops at the next gate boundary, leaving the qubit states as they were after the last applied gate.
+It returns 0 if cancellation was requested, -1 if the job is NULL, or -2 if the job had already completed.
+*/
+int cancelJob(CircuitJob *job)
+{
+}
+
+/*
+This function releases a job handle. It waits for the job to finish first, so it is safe to call on a
+job that is still pending or running. Called from the job's own completion callback it does not wait; the job
+is freed when the callback returns, and no other thread may use the handle after that. The submitted circuit
+is not destroyed.
+*/
+void destroyJob(CircuitJob *job)
+{
+}
+
+/*
+This function stops the asynchronous job executor. Jobs that are already queued are still executed,
+then the worker threads exit and are joined. Concurrent calls are safe: later callers wait for the shutdown in
+progress. It must not be called from a completion callback. A later call to submitCircuit() starts the executor again.
+*/
+void shutdownExecutor(void)
+{
+}
+
+/*
+This function simulates a quantum circuit under a noise model using Monte Carlo trajectories.
+Like executeCircuit(), every trajectory replays the recorded gates starting from every qubit in state 0,
+injecting depolarizing, bit-flip and amplitude damping errors on the qubits of each gate, and finally reads out
+every qubit with readout error. The position of each trajectory's first error is sampled up front from the
+noiseless run, and the trajectories are sorted by it, so the error-free part of each trajectory is taken from
+a shared noiseless state instead of being simulated again. Trajectories run on up to TRAJECTORY_THREADS threads,
+each with its own random stream derived from seed, so the result does not depend on the number of threads.
+The circuit itself is not modified. On success onesCounts[i] holds how many trajectories read qubit i as 1.
+These are marginal counts only; to see correlations between qubits, such as between the control and target of a
+two-qubit gate, pass an outcomes array of numTrajectories * numQubits entries and outcomes[t * numQubits + i]
+receives the value read from qubit i in trajectory t. Pass NULL for outcomes when only the counts are needed.
+It returns 0 on success, -1 if the circuit is NULL, -2 if any other argument is invalid,
+or -3 if memory allocation fails.
+*/
+int runNoisyTrajectories(QuantumCircuit *circuit, const NoiseModel *noise, int numTrajectories, unsigned long seed, int *onesCounts,
+                         int *outcomes)
+{
+}
+
+/*
+This function computes the exact expectation value <psi|H|psi> of a weighted sum of Pauli strings
+H = sum of terms[k].coefficient * terms[k].paulis without sampling. Like executeCircuit() and
+runNoisyTrajectories(), psi is the basis state obtained by replaying the recorded gates from every qubit in state 0.
+Each Pauli string has one character per qubit from "IXYZ", where character i acts on qubit i.
+A term containing X or Y maps the basis state to an orthogonal one and contributes exactly 0, while a term made
+of I and Z contributes its coefficient times the parity sign of the qubits in state 1 under its Z factors.
+It returns 0 on success with the value stored in expectation, -1 if the circuit is NULL,
+-2 if any other argument or Pauli string is invalid, or -3 if memory allocation fails.
+*/
+int computeExpectationValue(QuantumCircuit *circuit, const PauliTerm *terms, int numTerms, double *expectation)
+{
+}
@@ -1,5 +1,14 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
+// The job executor and the trajectory engine use POSIX threads: link with -pthread
+#include <pthread.h>
+
+// Number of worker threads used by the asynchronous job executor
+#define EXECUTOR_THREADS 4
+
+// Number of worker threads used to run noisy trajectories in parallel
+#define TRAJECTORY_THREADS 4
 
 typedef enum
 {
@@ -24,6 +33,58 @@ typedef struct
     int numGates;
 } QuantumCircuit;
 
+typedef struct
+{
+    int numGatesApplied;
+    long bytesMoved;
+    double seconds;
+    double bandwidth;
+} ExecutionStats;
+
+typedef struct
+{
+    double depolarizing;
+    double bitFlip;
+    double amplitudeDamping;
+    double readoutError;
+} NoiseModel;
+
+typedef struct
+{
+    double coefficient;
+    const char *paulis;
+} PauliTerm;
+
+typedef enum
+{
+    JOB_PENDING,
+    JOB_RUNNING,
+    JOB_COMPLETED,
+    JOB_CANCELLED
+} JobStatus;
+
+typedef struct CircuitJob CircuitJob;
+
+typedef void (*JobCallback)(CircuitJob *job, void *userData);
+
+struct CircuitJob
+{
+    QuantumCircuit *circuit;
+    JobStatus status;
+    int cancelRequested;
+    int finished;
+    int inCallback;
+    pthread_t callbackThread;
+    int released;
+    int result;
+    ExecutionStats stats;
+    JobCallback callback;
+    void *userData;
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    CircuitJob *next;
+};
+
 QuantumCircuit *createQuantumCircuit(int numQubits);
 
 void addGateToCircuit(QuantumCircuit *circuit, GateType gateType, int qubitIndex);
@@ -35,3 +96,22 @@ int applySingleQubitGate(int qubitState, GateType gateType, QuantumCircuit *circ
 int applyTwoQubitGate(int qubitState1, int qubitState2, GateType gateType, QuantumCircuit *circuit);
 
 int measureQubit(QuantumCircuit *circuit, int qubitIndex);
+
+int executeCircuit(QuantumCircuit *circuit, ExecutionStats *stats);
+
+CircuitJob *submitCircuit(QuantumCircuit *circuit, JobCallback callback, void *userData);
+
+JobStatus pollJob(CircuitJob *job);
+
+int waitForJob(CircuitJob *job, int timeoutMs);
+
+int cancelJob(CircuitJob *job);
+
+void destroyJob(CircuitJob *job);
+
+void shutdownExecutor(void);
+
+int runNoisyTrajectories(QuantumCircuit *circuit, const NoiseModel *noise, int numTrajectories, unsigned long seed, int *onesCounts,
+                         int *outcomes);
+
+int computeExpectationValue(QuantumCircuit *circuit, const PauliTerm *terms, int numTerms, double *expectation);
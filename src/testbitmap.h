@@ -184,4 +184,504 @@ public:
         TS_ASSERT_EQUALS(circuit->numGates, 2);
         destroyQuantumCircuit(circuit);
     }
+
+    /////////////////////////////////////////////////////////////////
+
+    void testExecuteCircuit()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(4);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 1);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 3);
+        ExecutionStats stats;
+        int result = executeCircuit(circuit, &stats);
+        TS_ASSERT_EQUALS(result, 0);
+        TS_ASSERT_EQUALS(circuit->qubitStates[0], 1);
+        TS_ASSERT_EQUALS(circuit->qubitStates[1], 1);
+        TS_ASSERT_EQUALS(circuit->qubitStates[2], 0);
+        TS_ASSERT_EQUALS(circuit->qubitStates[3], 1);
+        TS_ASSERT_EQUALS(stats.numGatesApplied, 3);
+        // Resetting four states, then one gate record read and one state read and written per gate
+        TS_ASSERT_EQUALS(stats.bytesMoved, (long)(4 * sizeof(int) + 3 * (sizeof(Gate) + 2 * sizeof(int))));
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testExecuteCircuitTwoQubitGate()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(3);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        addGateToCircuit(circuit, TWO_QUBIT_GATE, 0);
+        ExecutionStats stats;
+        int result = executeCircuit(circuit, &stats);
+        TS_ASSERT_EQUALS(result, 0);
+        TS_ASSERT_EQUALS(circuit->qubitStates[0], 1);
+        TS_ASSERT_EQUALS(circuit->qubitStates[1], 1);
+        TS_ASSERT_EQUALS(stats.numGatesApplied, 3);
+        // The pair reads both records and its control, and flips the target because the control is 1
+        TS_ASSERT_EQUALS(stats.bytesMoved, (long)(3 * sizeof(Gate) + 8 * sizeof(int)));
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testExecuteCircuitReplaysFromZero()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        applySingleQubitGate(0, SINGLE_QUBIT_GATE, circuit);
+        TS_ASSERT_EQUALS(executeCircuit(circuit, NULL), 0);
+        TS_ASSERT_EQUALS(circuit->qubitStates[0], 1);
+        TS_ASSERT_EQUALS(executeCircuit(circuit, NULL), 0);
+        TS_ASSERT_EQUALS(circuit->qubitStates[0], 1);
+        TS_ASSERT_EQUALS(circuit->qubitStates[1], 0);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testExecuteCircuitBandwidth()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(64);
+        for (int i = 0; i < 64; i++)
+        {
+            addGateToCircuit(circuit, SINGLE_QUBIT_GATE, i);
+        }
+        ExecutionStats stats;
+        TS_ASSERT_EQUALS(executeCircuit(circuit, &stats), 0);
+        TS_ASSERT_EQUALS(stats.bytesMoved, (long)(64 * sizeof(int) + 64 * (sizeof(Gate) + 2 * sizeof(int))));
+        TS_ASSERT(stats.seconds >= 0);
+        if (stats.seconds > 0)
+        {
+            TS_ASSERT_DELTA(stats.bandwidth, stats.bytesMoved / stats.seconds, 1e-6 * stats.bandwidth);
+        }
+        else
+        {
+            TS_ASSERT_EQUALS(stats.bandwidth, 0.0);
+        }
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testExecuteCircuitInvalidCircuit()
+    {
+        QuantumCircuit *circuit = NULL;
+        int result = executeCircuit(circuit, NULL);
+        TS_ASSERT_EQUALS(result, -1);
+    }
+
+    /////////////////////////////////////////////////////////////////
+
+    static void countCompletion(CircuitJob *job, void *userData)
+    {
+        int *completions = (int *)userData;
+        if (job->status == JOB_COMPLETED)
+        {
+            (*completions)++;
+        }
+    }
+
+    void testSubmitCircuit()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 1);
+        int completions = 0;
+        CircuitJob *job = submitCircuit(circuit, countCompletion, &completions);
+        TS_ASSERT(job != NULL);
+        TS_ASSERT_EQUALS(waitForJob(job, -1), 0);
+        TS_ASSERT_EQUALS(pollJob(job), JOB_COMPLETED);
+        TS_ASSERT_EQUALS(job->result, 0);
+        TS_ASSERT_EQUALS(job->stats.numGatesApplied, 1);
+        TS_ASSERT_EQUALS(completions, 1);
+        TS_ASSERT_EQUALS(circuit->qubitStates[1], 1);
+        TS_ASSERT_EQUALS(cancelJob(job), -2);
+        destroyJob(job);
+        shutdownExecutor();
+        destroyQuantumCircuit(circuit);
+    }
+
+    struct WorkerGate
+    {
+        pthread_mutex_t lock;
+        pthread_cond_t changed;
+        int entered;
+        int released;
+    };
+
+    static void holdWorker(CircuitJob *job, void *userData)
+    {
+        (void)job;
+        WorkerGate *gate = (WorkerGate *)userData;
+        pthread_mutex_lock(&gate->lock);
+        gate->entered++;
+        pthread_cond_broadcast(&gate->changed);
+        while (!gate->released)
+        {
+            pthread_cond_wait(&gate->changed, &gate->lock);
+        }
+        pthread_mutex_unlock(&gate->lock);
+    }
+
+    void testCancelPendingJob()
+    {
+        // Occupy every executor thread inside a completion callback so the next job stays pending
+        WorkerGate gate;
+        pthread_mutex_init(&gate.lock, NULL);
+        pthread_cond_init(&gate.changed, NULL);
+        gate.entered = 0;
+        gate.released = 0;
+        QuantumCircuit *blockerCircuits[EXECUTOR_THREADS];
+        CircuitJob *blockers[EXECUTOR_THREADS];
+        for (int i = 0; i < EXECUTOR_THREADS; i++)
+        {
+            blockerCircuits[i] = createQuantumCircuit(1);
+            blockers[i] = submitCircuit(blockerCircuits[i], holdWorker, &gate);
+        }
+        pthread_mutex_lock(&gate.lock);
+        while (gate.entered < EXECUTOR_THREADS)
+        {
+            pthread_cond_wait(&gate.changed, &gate.lock);
+        }
+        pthread_mutex_unlock(&gate.lock);
+
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        circuit->qubitStates[1] = 1;
+        CircuitJob *job = submitCircuit(circuit, NULL, NULL);
+        TS_ASSERT_EQUALS(pollJob(job), JOB_PENDING);
+        TS_ASSERT_EQUALS(waitForJob(job, 20), 1);
+        TS_ASSERT_EQUALS(waitForJob(blockers[0], 20), 1);
+        // Execution has ended but the callback has not returned, which pollJob() reports as running
+        TS_ASSERT_EQUALS(pollJob(blockers[0]), JOB_RUNNING);
+        TS_ASSERT_EQUALS(cancelJob(job), 0);
+
+        pthread_mutex_lock(&gate.lock);
+        gate.released = 1;
+        pthread_cond_broadcast(&gate.changed);
+        pthread_mutex_unlock(&gate.lock);
+        TS_ASSERT_EQUALS(waitForJob(job, -1), 0);
+        TS_ASSERT_EQUALS(pollJob(job), JOB_CANCELLED);
+        TS_ASSERT_EQUALS(job->result, -2);
+        // The job never ran, so the circuit was not replayed
+        TS_ASSERT_EQUALS(circuit->qubitStates[0], 0);
+        TS_ASSERT_EQUALS(circuit->qubitStates[1], 1);
+        for (int i = 0; i < EXECUTOR_THREADS; i++)
+        {
+            TS_ASSERT_EQUALS(waitForJob(blockers[i], -1), 0);
+            TS_ASSERT_EQUALS(pollJob(blockers[i]), JOB_COMPLETED);
+            destroyJob(blockers[i]);
+            destroyQuantumCircuit(blockerCircuits[i]);
+        }
+        destroyJob(job);
+        shutdownExecutor();
+        destroyQuantumCircuit(circuit);
+        pthread_cond_destroy(&gate.changed);
+        pthread_mutex_destroy(&gate.lock);
+    }
+
+    void testCancelRunningJob()
+    {
+        // Large enough that execution is still running when the cancellation arrives
+        int numQubits = 1 << 22;
+        QuantumCircuit *circuit = createQuantumCircuit(numQubits);
+        for (int i = 0; i < numQubits; i++)
+        {
+            addGateToCircuit(circuit, SINGLE_QUBIT_GATE, i);
+        }
+        CircuitJob *job = submitCircuit(circuit, NULL, NULL);
+        // Wait up to five seconds for a worker to pick the job up, sleeping instead of spinning
+        struct timespec pause = {0, 100000};
+        for (int i = 0; i < 50000 && pollJob(job) == JOB_PENDING; i++)
+        {
+            nanosleep(&pause, NULL);
+        }
+        int cancelled = cancelJob(job);
+        TS_ASSERT_EQUALS(waitForJob(job, -1), 0);
+        int applied = job->stats.numGatesApplied;
+        if (cancelled == 0)
+        {
+            TS_ASSERT_EQUALS(pollJob(job), JOB_CANCELLED);
+            TS_ASSERT_EQUALS(job->result, -2);
+            TS_ASSERT(applied < numQubits);
+        }
+        else
+        {
+            // A preempted test thread can miss the running window; the replay must then be complete
+            TS_ASSERT_EQUALS(cancelled, -2);
+            TS_ASSERT_EQUALS(pollJob(job), JOB_COMPLETED);
+            TS_ASSERT_EQUALS(applied, numQubits);
+        }
+        // Execution stopped between two gates: exactly the first applied gates took effect
+        int consistent = 1;
+        for (int i = 0; i < numQubits; i++)
+        {
+            if (circuit->qubitStates[i] != (i < applied))
+            {
+                consistent = 0;
+            }
+        }
+        TS_ASSERT(consistent);
+        destroyJob(job);
+        shutdownExecutor();
+        destroyQuantumCircuit(circuit);
+    }
+
+    struct ReleaseSignal
+    {
+        pthread_mutex_t lock;
+        pthread_cond_t changed;
+        int released;
+    };
+
+    static void releaseFromCallback(CircuitJob *job, void *userData)
+    {
+        ReleaseSignal *signal = (ReleaseSignal *)userData;
+        destroyJob(job);
+        pthread_mutex_lock(&signal->lock);
+        signal->released = 1;
+        pthread_cond_broadcast(&signal->changed);
+        pthread_mutex_unlock(&signal->lock);
+    }
+
+    void testDestroyJobFromCallback()
+    {
+        ReleaseSignal signal;
+        pthread_mutex_init(&signal.lock, NULL);
+        pthread_cond_init(&signal.changed, NULL);
+        signal.released = 0;
+        QuantumCircuit *circuit = createQuantumCircuit(1);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        TS_ASSERT(submitCircuit(circuit, releaseFromCallback, &signal) != NULL);
+        pthread_mutex_lock(&signal.lock);
+        while (!signal.released)
+        {
+            pthread_cond_wait(&signal.changed, &signal.lock);
+        }
+        pthread_mutex_unlock(&signal.lock);
+        // Returns only if the worker was not left waiting on the released job
+        shutdownExecutor();
+        TS_ASSERT_EQUALS(circuit->qubitStates[0], 1);
+        destroyQuantumCircuit(circuit);
+        pthread_cond_destroy(&signal.changed);
+        pthread_mutex_destroy(&signal.lock);
+    }
+
+    static void *shutdownFromThread(void *arg)
+    {
+        (void)arg;
+        shutdownExecutor();
+        return NULL;
+    }
+
+    void testConcurrentShutdown()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(1);
+        CircuitJob *job = submitCircuit(circuit, NULL, NULL);
+        TS_ASSERT_EQUALS(waitForJob(job, -1), 0);
+        pthread_t threads[2];
+        for (int i = 0; i < 2; i++)
+        {
+            pthread_create(&threads[i], NULL, shutdownFromThread, NULL);
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        // The executor restarts after a shutdown
+        CircuitJob *next = submitCircuit(circuit, NULL, NULL);
+        TS_ASSERT(next != NULL);
+        TS_ASSERT_EQUALS(waitForJob(next, -1), 0);
+        destroyJob(next);
+        destroyJob(job);
+        shutdownExecutor();
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testSubmitCircuitInvalidCircuit()
+    {
+        QuantumCircuit *circuit = NULL;
+        CircuitJob *job = submitCircuit(circuit, NULL, NULL);
+        TS_ASSERT(job == NULL);
+        TS_ASSERT_EQUALS(waitForJob(job, 0), -1);
+        TS_ASSERT_EQUALS(cancelJob(job), -1);
+    }
+
+    /////////////////////////////////////////////////////////////////
+
+    void testRunNoisyTrajectoriesNoiseless()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        NoiseModel noise = {0.0, 0.0, 0.0, 0.0};
+        int onesCounts[2];
+        int result = runNoisyTrajectories(circuit, &noise, 100, 1, onesCounts, NULL);
+        TS_ASSERT_EQUALS(result, 0);
+        TS_ASSERT_EQUALS(onesCounts[0], 100);
+        TS_ASSERT_EQUALS(onesCounts[1], 0);
+        TS_ASSERT_EQUALS(circuit->qubitStates[0], 0);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesBitFlip()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        NoiseModel noise = {0.0, 1.0, 0.0, 0.0};
+        int onesCounts[2];
+        int result = runNoisyTrajectories(circuit, &noise, 50, 7, onesCounts, NULL);
+        TS_ASSERT_EQUALS(result, 0);
+        TS_ASSERT_EQUALS(onesCounts[0], 0);
+        TS_ASSERT_EQUALS(onesCounts[1], 0);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesReproducible()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        NoiseModel noise = {0.1, 0.05, 0.2, 0.02};
+        int first[2];
+        int second[2];
+        runNoisyTrajectories(circuit, &noise, 1000, 42, first, NULL);
+        runNoisyTrajectories(circuit, &noise, 1000, 42, second, NULL);
+        TS_ASSERT_EQUALS(first[0], second[0]);
+        TS_ASSERT_EQUALS(first[1], second[1]);
+        TS_ASSERT(first[0] > 0 && first[0] < 1000);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesMatchesClosedForm()
+    {
+        // X on qubit 0, then a CNOT pair from qubit 0 to qubit 1, with every error channel enabled
+        QuantumCircuit *circuit = createQuantumCircuit(3);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        addGateToCircuit(circuit, TWO_QUBIT_GATE, 0);
+        NoiseModel noise = {0.15, 0.07, 0.3, 0.05};
+        int numTrajectories = 20000;
+        int onesCounts[3];
+        int *outcomes = (int *)malloc(numTrajectories * 3 * sizeof(int));
+        TS_ASSERT_EQUALS(runNoisyTrajectories(circuit, &noise, numTrajectories, 11, onesCounts, outcomes), 0);
+
+        // Per gate a qubit flips with probability flip, then a qubit in state 1 decays with the damping rate
+        double depolarizingFlip = noise.depolarizing * 2.0 / 3.0;
+        double flip = depolarizingFlip * (1.0 - noise.bitFlip) + (1.0 - depolarizingFlip) * noise.bitFlip;
+        double afterGateFromZero = flip * (1.0 - noise.amplitudeDamping);
+        double afterGateFromOne = (1.0 - flip) * (1.0 - noise.amplitudeDamping);
+        double readZero = afterGateFromZero * (1.0 - noise.readoutError) + (1.0 - afterGateFromZero) * noise.readoutError;
+        double readOne = afterGateFromOne * (1.0 - noise.readoutError) + (1.0 - afterGateFromOne) * noise.readoutError;
+        // After the X gate qubit 0 is 1 with probability control; the CNOT copies it onto qubit 1
+        double control = afterGateFromOne;
+        double expectedOne = control * readOne + (1.0 - control) * readZero;
+        double expectedBoth = control * readOne * readOne + (1.0 - control) * readZero * readZero;
+
+        int bothOnes = 0;
+        for (int t = 0; t < numTrajectories; t++)
+        {
+            bothOnes += outcomes[t * 3] && outcomes[t * 3 + 1];
+        }
+        // The tolerance of 0.02 is more than five standard deviations at 20000 trajectories
+        TS_ASSERT_DELTA(onesCounts[0] / (double)numTrajectories, expectedOne, 0.02);
+        TS_ASSERT_DELTA(onesCounts[1] / (double)numTrajectories, expectedOne, 0.02);
+        TS_ASSERT_DELTA(onesCounts[2] / (double)numTrajectories, noise.readoutError, 0.02);
+        TS_ASSERT_DELTA(bothOnes / (double)numTrajectories, expectedBoth, 0.02);
+        free(outcomes);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesGateNoiseRates()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 1);
+        NoiseModel noise = {0.0, 0.1, 0.0, 0.0};
+        int onesCounts[2];
+        int result = runNoisyTrajectories(circuit, &noise, 10000, 3, onesCounts, NULL);
+        TS_ASSERT_EQUALS(result, 0);
+        // Each qubit keeps its X with probability 0.9, the tolerance is about seven standard deviations
+        TS_ASSERT(onesCounts[0] > 8800 && onesCounts[0] < 9200);
+        TS_ASSERT(onesCounts[1] > 8800 && onesCounts[1] < 9200);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesAmplitudeDamping()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        NoiseModel noise = {0.0, 0.0, 1.0, 0.0};
+        int onesCounts[2];
+        int result = runNoisyTrajectories(circuit, &noise, 100, 5, onesCounts, NULL);
+        TS_ASSERT_EQUALS(result, 0);
+        TS_ASSERT_EQUALS(onesCounts[0], 0);
+        TS_ASSERT_EQUALS(onesCounts[1], 0);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesIgnoresStoredStates()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        applySingleQubitGate(0, SINGLE_QUBIT_GATE, circuit);
+        circuit->qubitStates[1] = 1;
+        NoiseModel noise = {0.0, 0.0, 0.0, 0.0};
+        int onesCounts[2];
+        TS_ASSERT_EQUALS(runNoisyTrajectories(circuit, &noise, 10, 1, onesCounts, NULL), 0);
+        TS_ASSERT_EQUALS(onesCounts[0], 10);
+        TS_ASSERT_EQUALS(onesCounts[1], 0);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesEmptyCircuit()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(0);
+        NoiseModel noise = {0.1, 0.1, 0.1, 0.1};
+        int onesCounts[1];
+        TS_ASSERT_EQUALS(runNoisyTrajectories(circuit, &noise, 10, 1, onesCounts, NULL), 0);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testRunNoisyTrajectoriesInvalidArguments()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(1);
+        NoiseModel noise = {0.0, 1.5, 0.0, 0.0};
+        int onesCounts[1];
+        TS_ASSERT_EQUALS(runNoisyTrajectories(NULL, &noise, 10, 1, onesCounts, NULL), -1);
+        TS_ASSERT_EQUALS(runNoisyTrajectories(circuit, &noise, 10, 1, onesCounts, NULL), -2);
+        TS_ASSERT_EQUALS(runNoisyTrajectories(circuit, NULL, 10, 1, onesCounts, NULL), -2);
+        destroyQuantumCircuit(circuit);
+    }
+
+    /////////////////////////////////////////////////////////////////
+
+    void testComputeExpectationValue()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(3);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 2);
+        PauliTerm terms[] = {{0.5, "ZII"}, {2.0, "ZZZ"}, {1.0, "XII"}, {3.0, "III"}};
+        double expectation = 0.0;
+        int result = computeExpectationValue(circuit, terms, 4, &expectation);
+        TS_ASSERT_EQUALS(result, 0);
+        TS_ASSERT_DELTA(expectation, 4.5, 1e-12);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testComputeExpectationValueMatchesTrajectories()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        addGateToCircuit(circuit, SINGLE_QUBIT_GATE, 0);
+        PauliTerm terms[] = {{1.0, "ZI"}};
+        double expectation = 0.0;
+        TS_ASSERT_EQUALS(computeExpectationValue(circuit, terms, 1, &expectation), 0);
+        TS_ASSERT_DELTA(expectation, -1.0, 1e-12);
+        NoiseModel noise = {0.0, 0.0, 0.0, 0.0};
+        int onesCounts[2];
+        TS_ASSERT_EQUALS(runNoisyTrajectories(circuit, &noise, 10, 1, onesCounts, NULL), 0);
+        TS_ASSERT_EQUALS(onesCounts[0], 10);
+        destroyQuantumCircuit(circuit);
+    }
+
+    void testComputeExpectationValueInvalidTerms()
+    {
+        QuantumCircuit *circuit = createQuantumCircuit(2);
+        PauliTerm badCharacter[] = {{1.0, "ZA"}};
+        PauliTerm badLength[] = {{1.0, "ZZZ"}};
+        double expectation = 0.0;
+        TS_ASSERT_EQUALS(computeExpectationValue(NULL, badCharacter, 1, &expectation), -1);
+        TS_ASSERT_EQUALS(computeExpectationValue(circuit, badCharacter, 1, &expectation), -2);
+        TS_ASSERT_EQUALS(computeExpectationValue(circuit, badLength, 1, &expectation), -2);
+        TS_ASSERT_EQUALS(computeExpectationValue(circuit, badLength, 1, NULL), -2);
+        destroyQuantumCircuit(circuit);
+    }
 };
\ No newline at end of file